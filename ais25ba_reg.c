@@ -177,12 +177,12 @@ int32_t ais25ba_bus_mode_set(const stmdev_ctx_t *ctx,
     ret = ais25ba_read_reg(ctx, AIS25BA_TDM_CMAX_H, reg, 2);
     bytecpy((uint8_t *)&tdm_cmax_h, &reg[0]);
     bytecpy((uint8_t *)&tdm_cmax_l, &reg[1]);
-    tdm_ctrl_reg.tdm_pd = ~val->tdm.en;
+    tdm_ctrl_reg.tdm_pd = (val->tdm.en == PROPERTY_ENABLE) ? 0U : 1U;
     tdm_ctrl_reg.data_valid = val->tdm.clk_pol;
     tdm_ctrl_reg.delayed = val->tdm.clk_edge;
-    tdm_ctrl_reg.wclk_fq = val->tdm.mapping;
+    tdm_ctrl_reg.mapping = val->tdm.mapping;
     tdm_cmax_h.tdm_cmax = (uint8_t)(val->tdm.cmax / 256U);
-    tdm_cmax_l.tdm_cmax = (uint8_t)(val->tdm.cmax - tdm_cmax_h.tdm_cmax);
+    tdm_cmax_l.tdm_cmax = (uint8_t)(val->tdm.cmax % 256U);
   }
 
   if (ret == 0)
@@ -230,10 +230,10 @@ int32_t ais25ba_bus_mode_get(const stmdev_ctx_t *ctx,
   }
 
   if (ret == 0) {
-    val->tdm.en = ~tdm_ctrl_reg.tdm_pd;
+    val->tdm.en = (tdm_ctrl_reg.tdm_pd == PROPERTY_ENABLE) ? 0U : 1U;
     val->tdm.clk_pol = tdm_ctrl_reg.data_valid;
     val->tdm.clk_edge = tdm_ctrl_reg.delayed;
-    val->tdm.mapping = tdm_ctrl_reg.wclk_fq;
+    val->tdm.mapping = tdm_ctrl_reg.mapping;
     val->tdm.cmax = tdm_cmax_h.tdm_cmax * 256U;
     val->tdm.cmax += tdm_cmax_l.tdm_cmax;
   }
@@ -385,6 +385,154 @@ int32_t ais25ba_data_get(uint16_t *tdm_stream, ais25ba_bus_mode_t *md,
   return 0;
 }
 
+/**
+  * @brief  Read a block of consecutive frames in raw format.[get]
+  *
+  * @param  tdm_stream  data stream from TDM interface, frames are
+  *                     AIS25BA_TDM_SLOTS slots apart.(ptr)
+  * @param  md          the TDM interface configuration.(ptr)
+  * @param  frames      number of frames to decode.
+  * @param  raw         x/y/z raw samples, interleaved (3 * frames).(ptr)
+  *
+  * @retval             interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_raw_block_get(const uint16_t *tdm_stream,
+                              const ais25ba_bus_mode_t *md,
+                              uint32_t frames, int16_t *raw)
+{
+  const uint16_t *slot;
+  uint32_t i;
+
+  if ((tdm_stream == NULL) || (md == NULL) || (raw == NULL)) { return -1; }
+
+  if (md->tdm.mapping == PROPERTY_DISABLE)
+  {
+    slot = &tdm_stream[0]; /* slot0-1-2 */
+  }
+
+  else
+  {
+    slot = &tdm_stream[4]; /* slot4-5-6 */
+  }
+
+  for (i = 0U; i < frames; i++)
+  {
+    raw[0] = (int16_t)slot[0];
+    raw[1] = (int16_t)slot[1];
+    raw[2] = (int16_t)slot[2];
+    raw = &raw[3];
+    slot = &slot[AIS25BA_TDM_SLOTS];
+  }
+
+  return 0;
+}
+
+static int32_t tdm_layout_check(const ais25ba_tdm_layout_t *layout)
+{
+  if ((layout->width != AIS25BA_SLOT_16bit) &&
+      (layout->width != AIS25BA_SLOT_24bit) &&
+      (layout->width != AIS25BA_SLOT_32bit))
+  {
+    return -1;
+  }
+
+  if ((layout->justify != AIS25BA_SLOT_LEFT) &&
+      (layout->justify != AIS25BA_SLOT_RIGHT))
+  {
+    return -1;
+  }
+
+  if ((layout->byte_order != DRV_LITTLE_ENDIAN) &&
+      (layout->byte_order != DRV_BIG_ENDIAN))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Read a block of frames in raw format from a DMA buffer with
+  *         the given slot layout, unpacking bytes on the fly.[get]
+  *
+  * @param  tdm_stream  data stream from TDM interface, frames are
+  *                     AIS25BA_TDM_SLOTS slots apart.(ptr)
+  * @param  layout      slot width, justification and byte order.(ptr)
+  * @param  md          the TDM interface configuration.(ptr)
+  * @param  frames      number of frames to decode.
+  * @param  raw         x/y/z raw samples, interleaved (3 * frames).(ptr)
+  *
+  * @retval             interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_raw_block_layout_get(const uint8_t *tdm_stream,
+                                     const ais25ba_tdm_layout_t *layout,
+                                     const ais25ba_bus_mode_t *md,
+                                     uint32_t frames, int16_t *raw)
+{
+  const uint8_t *slot;
+  uint32_t size;
+  uint32_t msb;
+  uint32_t lsb;
+  uint32_t i;
+
+  if ((tdm_stream == NULL) || (layout == NULL) || (md == NULL) ||
+      (raw == NULL))
+  {
+    return -1;
+  }
+
+  if (tdm_layout_check(layout) != 0) { return -1; }
+
+  size = (uint32_t)layout->width;
+
+  /* byte positions of the 16 bit sample inside the slot */
+  if (layout->justify == AIS25BA_SLOT_LEFT)
+  {
+    msb = 0U;
+  }
+
+  else
+  {
+    msb = size - 2U;
+  }
+
+  if (layout->byte_order == DRV_BIG_ENDIAN)
+  {
+    lsb = msb + 1U;
+  }
+
+  else
+  {
+    msb = size - 1U - msb;
+    lsb = msb - 1U;
+  }
+
+  if (md->tdm.mapping == PROPERTY_DISABLE)
+  {
+    slot = &tdm_stream[0]; /* slot0-1-2 */
+  }
+
+  else
+  {
+    slot = &tdm_stream[4U * size]; /* slot4-5-6 */
+  }
+
+  for (i = 0U; i < frames; i++)
+  {
+    raw[0] = (int16_t)(uint16_t)(((uint16_t)slot[msb] << 8) | slot[lsb]);
+    raw[1] = (int16_t)(uint16_t)(((uint16_t)slot[msb + size] << 8) |
+                                 slot[lsb + size]);
+    raw[2] = (int16_t)(uint16_t)(((uint16_t)slot[msb + (2U * size)] << 8) |
+                                 slot[lsb + (2U * size)]);
+    raw = &raw[3];
+    slot = &slot[AIS25BA_TDM_SLOTS * size];
+  }
+
+  return 0;
+}
+
 /**
   * @brief  Linear acceleration sensor self-test enable.[set]
   *
@@ -431,6 +579,1315 @@ int32_t ais25ba_self_test_get(const stmdev_ctx_t *ctx, uint8_t *val)
   return ret;
 }
 
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup  AIS25BA_Timestamp
+  * @brief     This section groups all the functions concerning sample
+  *            timestamping and ODR drift estimation. Mainly useful when
+  *            odr is AIS25BA_XL_HW_SEL, where the actual sampling rate
+  *            follows the MCLK/WCLK ratio.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Timestamp estimator initialization.[set]
+  *         The loop corrects 2^-kp_shift of the phase error and
+  *         2^-ki_shift of the per-frame period error at every block.
+  *         Its time constant is about 2^kp_shift blocks; use
+  *         ki_shift = 2 * kp_shift + 2 for a critically damped loop.
+  *         Host timestamp jitter J (ticks) on blocks of N frames shows
+  *         up as drift noise of roughly J / (N * T) * 2^-ki_shift,
+  *         where T is the sample period in ticks: raise the shifts
+  *         (AIS25BA_TS_KP_SHIFT / AIS25BA_TS_KI_SHIFT by default) when
+  *         the block time stamps are noisy.
+  *
+  * @param  ts        timestamp estimator state.(ptr)
+  * @param  tick_hz   frequency of the host timestamp counter.
+  * @param  odr_hz    nominal sensor output data rate.
+  * @param  kp_shift  phase loop gain = 2^-kp_shift (max 30).
+  * @param  ki_shift  frequency loop gain = 2^-ki_shift (max 30).
+  *
+  * @retval           interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_ts_init(ais25ba_ts_t *ts, uint32_t tick_hz, float_t odr_hz,
+                        uint8_t kp_shift, uint8_t ki_shift)
+{
+  uint64_t odr_mhz;
+
+  if ((ts == NULL) || (tick_hz == 0U) || (odr_hz <= 0.0f) ||
+      (kp_shift > 30U) || (ki_shift > 30U))
+  {
+    return -1;
+  }
+
+  /* integer Q16 period: odr in mHz keeps 64 bit headroom at any tick */
+  odr_mhz = (uint64_t)(((double)odr_hz * 1000.0) + 0.5);
+
+  if (odr_mhz == 0U) { return -1; }
+
+  ts->nominal = (int64_t)(((((uint64_t)tick_hz << 16) * 1000U) +
+                           (odr_mhz / 2U)) / odr_mhz);
+  ts->period = ts->nominal;
+  ts->ferr = 0;
+  ts->start = 0;
+  ts->next = 0;
+  ts->host = 0;
+  ts->tick_hz = tick_hz;
+  ts->blocks = 0U;
+  ts->kp_shift = kp_shift;
+  ts->ki_shift = ki_shift;
+
+  return 0;
+}
+
+/**
+  * @brief  Feed the estimator with the host time of a decoded block.[set]
+  *         host_ts must be sampled at the same point of every block
+  *         (e.g. DMA transfer complete) and refers to its last frame.
+  *         The counter is allowed to wrap around 32 bit.
+  *
+  * @param  ts       timestamp estimator state.(ptr)
+  * @param  host_ts  host time of the last frame in the block (ticks).
+  * @param  frames   number of frames in the block.
+  *
+  * @retval          interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_ts_block_update(ais25ba_ts_t *ts, uint32_t host_ts,
+                                uint32_t frames)
+{
+  int64_t meas;
+  int64_t err;
+  int64_t span;
+
+  if ((ts == NULL) || (frames == 0U)) { return -1; }
+
+  if (ts->blocks == 0U)
+  {
+    ts->host = (int64_t)host_ts;
+  }
+
+  else
+  {
+    ts->host += (int64_t)(uint32_t)(host_ts - (uint32_t)ts->host);
+
+    /* rebase by 2^32 ticks to keep Q16 values in range, outputs are
+       reported modulo 2^32 so they are not affected */
+    if (ts->host >= ((int64_t)1 << 40))
+    {
+      ts->host -= (int64_t)1 << 32;
+      ts->start -= (int64_t)1 << 48;
+      ts->next -= (int64_t)1 << 48;
+    }
+  }
+
+  meas = ts->host * 65536;
+  span = ts->period * (int64_t)frames;
+  err = meas - (ts->next + (ts->period * ((int64_t)frames - 1)));
+
+  /* a dropped block lands err about one span off: half a span tells it
+     apart from phase error even with jittered host timestamps */
+  if ((ts->blocks == 0U) || (err > (span / 2)) || (err < -(span / 2)))
+  {
+    /* first block or lost frames: re-align phase, keep period */
+    ts->start = meas - (ts->period * ((int64_t)frames - 1));
+  }
+
+  else
+  {
+    /* keep the remainder so small corrections are not truncated away */
+    ts->ferr += err / (int64_t)frames;
+    ts->period += ts->ferr / ((int64_t)1 << ts->ki_shift);
+    ts->ferr %= ((int64_t)1 << ts->ki_shift);
+    ts->start = ts->next + (err / ((int64_t)1 << ts->kp_shift));
+  }
+
+  ts->next = ts->start + (ts->period * (int64_t)frames);
+  ts->blocks++;
+
+  return 0;
+}
+
+/**
+  * @brief  Interpolated host time of a sample in the last block.[get]
+  *
+  * @param  ts   timestamp estimator state.(ptr)
+  * @param  idx  frame index inside the last block.
+  * @param  val  host time of the frame (ticks).(ptr)
+  *
+  * @retval      interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_ts_sample_get(const ais25ba_ts_t *ts, uint32_t idx,
+                              uint32_t *val)
+{
+  if ((ts == NULL) || (val == NULL) || (ts->blocks == 0U)) { return -1; }
+
+  *val = (uint32_t)((ts->start + (ts->period * (int64_t)idx)) / 65536);
+
+  return 0;
+}
+
+/**
+  * @brief  Estimated output data rate.[get]
+  *
+  * @param  ts   timestamp estimator state.(ptr)
+  * @param  val  estimated output data rate in Hz.(ptr)
+  *
+  * @retval      interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_ts_odr_get(const ais25ba_ts_t *ts, float_t *val)
+{
+  if ((ts == NULL) || (val == NULL) || (ts->period <= 0)) { return -1; }
+
+  *val = (float_t)(((double)ts->tick_hz * 65536.0) / (double)ts->period);
+
+  return 0;
+}
+
+/**
+  * @brief  Estimated sensor clock drift against host clock.[get]
+  *
+  * @param  ts   timestamp estimator state.(ptr)
+  * @param  val  drift in ppm, positive when the sensor runs fast.(ptr)
+  *
+  * @retval      interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_ts_drift_get(const ais25ba_ts_t *ts, float_t *val)
+{
+  if ((ts == NULL) || (val == NULL) || (ts->period <= 0)) { return -1; }
+
+  *val = (float_t)(((double)(ts->nominal - ts->period) * 1000000.0) /
+                   (double)ts->period);
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup  AIS25BA_Envelope
+  * @brief     This section groups all the functions concerning envelope
+  *            demodulation (band-pass, rectify, low-pass and decimate)
+  *            fused in a single integer pass over raw blocks.
+  *            ais25ba_env_init (and ais25ba_pipe_init with the envelope
+  *            stage enabled) designs the band-pass with sinf, cosf and
+  *            sqrtf: link the C math library (libm) when using it.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Envelope demodulator initialization.[set]
+  *
+  * @param  env     envelope demodulator state.(ptr)
+  * @param  odr_hz  sensor output data rate.
+  * @param  f_lo    band-pass lower edge in Hz.
+  * @param  f_hi    band-pass upper edge in Hz.
+  * @param  decim   decimation factor of the envelope output.
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_env_init(ais25ba_env_t *env, float_t odr_hz, float_t f_lo,
+                         float_t f_hi, uint16_t decim)
+{
+  float_t f0;
+  float_t w0;
+  float_t alpha;
+  float_t a0;
+  uint8_t i;
+
+  if ((env == NULL) || (decim == 0U) || (f_lo <= 0.0f) || (f_hi <= f_lo) ||
+      (f_hi >= (odr_hz / 2.0f)))
+  {
+    return -1;
+  }
+
+  /* constant 0 dB peak gain band-pass biquad centered on the band */
+  f0 = sqrtf(f_lo * f_hi);
+  w0 = (2.0f * 3.14159265f * f0) / odr_hz;
+  alpha = (sinf(w0) * (f_hi - f_lo)) / (2.0f * f0);
+  a0 = 1.0f + alpha;
+
+  env->b0 = (int32_t)((alpha / a0) * 268435456.0f);
+  env->a1 = (int32_t)(((-2.0f * cosf(w0)) / a0) * 268435456.0f);
+  env->a2 = (int32_t)(((1.0f - alpha) / a0) * 268435456.0f);
+
+  /* envelope low-pass corner close to the decimated Nyquist frequency */
+  env->lp_shift = 0U;
+  while ((((uint32_t)1U << env->lp_shift) < decim) && (env->lp_shift < 15U))
+  {
+    env->lp_shift++;
+  }
+
+  env->decim = decim;
+  env->cnt = 0U;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    env->axis[i].x1 = 0;
+    env->axis[i].x2 = 0;
+    env->axis[i].y1 = 0;
+    env->axis[i].y2 = 0;
+    env->axis[i].lp = 0;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Envelope demodulation of a raw block.[get]
+  *
+  * @param  env     envelope demodulator state.(ptr)
+  * @param  raw     x/y/z raw samples, interleaved (3 * frames).(ptr)
+  * @param  frames  number of input frames.
+  * @param  out     x/y/z envelope samples, interleaved; must hold
+  *                 3 * (frames / decim + 1) samples.(ptr)
+  * @param  len     number of envelope frames written in out.(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_env_process(ais25ba_env_t *env, const int16_t *raw,
+                            uint32_t frames, int16_t *out, uint32_t *len)
+{
+  int64_t acc;
+  int32_t y;
+  uint32_t n = 0U;
+  uint32_t i;
+  uint8_t j;
+
+  if ((env == NULL) || (raw == NULL) || (out == NULL) || (len == NULL))
+  {
+    return -1;
+  }
+
+  for (i = 0U; i < frames; i++)
+  {
+    env->cnt++;
+
+    for (j = 0U; j < 3U; j++)
+    {
+      acc = (int64_t)env->b0 * ((int32_t)raw[j] - env->axis[j].x2);
+      acc -= (int64_t)env->a1 * env->axis[j].y1;
+      acc -= (int64_t)env->a2 * env->axis[j].y2;
+      y = (int32_t)(acc / 268435456);
+
+      env->axis[j].x2 = env->axis[j].x1;
+      env->axis[j].x1 = (int32_t)raw[j];
+      env->axis[j].y2 = env->axis[j].y1;
+      env->axis[j].y1 = y;
+
+      /* full-wave rectify and low-pass */
+      y = (y < 0) ? -y : y;
+      env->axis[j].lp += ((y * 256) - env->axis[j].lp) /
+                         ((int32_t)1 << env->lp_shift);
+
+      if (env->cnt == env->decim)
+      {
+        y = env->axis[j].lp / 256;
+        out[(n * 3U) + j] = (y > 32767) ? (int16_t)32767 : (int16_t)y;
+      }
+    }
+
+    if (env->cnt == env->decim)
+    {
+      env->cnt = 0U;
+      n++;
+    }
+
+    raw = &raw[3];
+  }
+
+  *len = n;
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup  AIS25BA_Pyramid
+  * @brief     This section groups all the functions concerning the
+  *            multi-resolution min/max/mean/rms aggregation of raw data.
+  *            Every level stores its cells in a caller provided ring.
+  * @{
+  *
+  */
+
+static void pyr_acc_reset(ais25ba_pyr_acc_t *acc)
+{
+  uint8_t i;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    acc->sum[i] = 0;
+    acc->sumsq[i] = 0U;
+    acc->min[i] = 32767;
+    acc->max[i] = -32768;
+  }
+
+  acc->n = 0U;
+}
+
+static void pyr_acc_merge(ais25ba_pyr_acc_t *acc,
+                          const ais25ba_pyr_acc_t *src)
+{
+  uint8_t i;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    acc->min[i] = (src->min[i] < acc->min[i]) ? src->min[i] : acc->min[i];
+    acc->max[i] = (src->max[i] > acc->max[i]) ? src->max[i] : acc->max[i];
+    acc->sum[i] += src->sum[i];
+    acc->sumsq[i] += src->sumsq[i];
+  }
+
+  acc->n += src->n;
+}
+
+static void pyr_acc_cell(ais25ba_pyr_acc_t *acc,
+                         const ais25ba_pyr_cell_t *cell, uint32_t span)
+{
+  uint8_t i;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    acc->min[i] = (cell->min[i] < acc->min[i]) ? cell->min[i] : acc->min[i];
+    acc->max[i] = (cell->max[i] > acc->max[i]) ? cell->max[i] : acc->max[i];
+    acc->sum[i] += (int64_t)cell->mean[i] * (int64_t)span;
+    acc->sumsq[i] += ((uint64_t)cell->rms[i] * cell->rms[i]) * span;
+  }
+
+  acc->n += span;
+}
+
+/* floor of the square root, bit by bit (no libm) */
+static uint32_t pyr_isqrt(uint64_t val)
+{
+  uint64_t bit = (uint64_t)1 << 62;
+  uint64_t res = 0U;
+
+  while (bit > val) { bit >>= 2; }
+
+  while (bit != 0U)
+  {
+    if (val >= (res + bit))
+    {
+      val -= res + bit;
+      res = (res >> 1) + bit;
+    }
+
+    else
+    {
+      res >>= 1;
+    }
+
+    bit >>= 2;
+  }
+
+  return (uint32_t)res;
+}
+
+static void pyr_acc_close(const ais25ba_pyr_acc_t *acc,
+                          ais25ba_pyr_cell_t *cell)
+{
+  uint64_t ms;
+  uint32_t r;
+  uint8_t i;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    cell->min[i] = acc->min[i];
+    cell->max[i] = acc->max[i];
+
+    /* round to nearest, half away from zero */
+    if (acc->sum[i] >= 0)
+    {
+      cell->mean[i] = (int16_t)((acc->sum[i] + (int64_t)(acc->n / 2U)) /
+                                (int64_t)acc->n);
+    }
+
+    else
+    {
+      cell->mean[i] = (int16_t)(-((-acc->sum[i] + (int64_t)(acc->n / 2U)) /
+                                  (int64_t)acc->n));
+    }
+
+    /* integer square root of the mean square, rounded to nearest */
+    ms = (acc->sumsq[i] + (acc->n / 2U)) / acc->n;
+    r = pyr_isqrt(ms);
+
+    if ((ms - ((uint64_t)r * r)) > r) { r++; }
+
+    cell->rms[i] = (r > 65535U) ? (uint16_t)65535U : (uint16_t)r;
+  }
+}
+
+static const ais25ba_pyr_cell_t *pyr_cell_get(const ais25ba_pyr_level_t *lvl,
+                                              uint64_t idx)
+{
+  if ((idx >= lvl->cells) || ((lvl->cells - idx) > lvl->depth))
+  {
+    return NULL;
+  }
+
+  return &lvl->ring[(lvl->head + lvl->depth -
+                     (uint32_t)(lvl->cells - idx)) % lvl->depth];
+}
+
+static int32_t pyr_acc_level(ais25ba_pyr_acc_t *acc,
+                             const ais25ba_pyr_level_t *lvl, uint64_t frame)
+{
+  const ais25ba_pyr_cell_t *cell;
+
+  cell = pyr_cell_get(lvl, frame / lvl->span);
+
+  if (cell == NULL) { return -1; }
+
+  pyr_acc_cell(acc, cell, lvl->span);
+
+  return 0;
+}
+
+/**
+  * @brief  Aggregation pyramid initialization.[set]
+  *
+  * @param  pyr  aggregation pyramid.(ptr)
+  *
+  * @retval      interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pyr_init(ais25ba_pyr_t *pyr)
+{
+  if (pyr == NULL) { return -1; }
+
+  pyr->levels = 0U;
+
+  return 0;
+}
+
+/**
+  * @brief  Append a coarser level to the aggregation pyramid.[set]
+  *
+  * @param  pyr    aggregation pyramid.(ptr)
+  * @param  ring   cell storage of the level (depth cells).(ptr)
+  * @param  depth  number of cells retained by the level.
+  * @param  ratio  frames per cell for the first level, cells of the
+  *                previous level per cell otherwise; the product of
+  *                the ratios must fit in 32 bit.
+  *
+  * @retval        interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pyr_level_add(ais25ba_pyr_t *pyr, ais25ba_pyr_cell_t *ring,
+                              uint16_t depth, uint16_t ratio)
+{
+  ais25ba_pyr_level_t *lvl;
+
+  if ((pyr == NULL) || (ring == NULL) || (depth == 0U) || (ratio == 0U) ||
+      (pyr->levels >= AIS25BA_PYR_LEVELS))
+  {
+    return -1;
+  }
+
+  /* frames per cell must fit in 32 bit */
+  if ((pyr->levels > 0U) &&
+      (ratio > (UINT32_MAX / pyr->level[pyr->levels - 1U].span)))
+  {
+    return -1;
+  }
+
+  lvl = &pyr->level[pyr->levels];
+  lvl->ring = ring;
+  lvl->depth = depth;
+  lvl->ratio = ratio;
+  lvl->cells = 0U;
+  lvl->head = 0U;
+  lvl->span = ratio;
+
+  if (pyr->levels > 0U)
+  {
+    lvl->span *= pyr->level[pyr->levels - 1U].span;
+  }
+
+  pyr_acc_reset(&lvl->acc);
+  pyr->levels++;
+
+  return 0;
+}
+
+/**
+  * @brief  Feed the aggregation pyramid with a raw block.[set]
+  *
+  * @param  pyr     aggregation pyramid.(ptr)
+  * @param  raw     x/y/z raw samples, interleaved (3 * frames).(ptr)
+  * @param  frames  number of frames.
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pyr_update(ais25ba_pyr_t *pyr, const int16_t *raw,
+                           uint32_t frames)
+{
+  ais25ba_pyr_level_t *lvl;
+  uint32_t i;
+  uint8_t j;
+  uint8_t l;
+
+  if ((pyr == NULL) || (raw == NULL) || (pyr->levels == 0U)) { return -1; }
+
+  for (i = 0U; i < frames; i++)
+  {
+    lvl = &pyr->level[0];
+
+    for (j = 0U; j < 3U; j++)
+    {
+      lvl->acc.min[j] = (raw[j] < lvl->acc.min[j]) ? raw[j] : lvl->acc.min[j];
+      lvl->acc.max[j] = (raw[j] > lvl->acc.max[j]) ? raw[j] : lvl->acc.max[j];
+      lvl->acc.sum[j] += raw[j];
+      lvl->acc.sumsq[j] += (uint64_t)((int32_t)raw[j] * raw[j]);
+    }
+
+    lvl->acc.n++;
+    raw = &raw[3];
+
+    /* close full cells and cascade their exact sums to coarser levels */
+    for (l = 0U; (l < pyr->levels) && (lvl->acc.n == lvl->span); l++)
+    {
+      pyr_acc_close(&lvl->acc, &lvl->ring[lvl->head]);
+      lvl->head = ((lvl->head + 1U) == lvl->depth) ? 0U : (lvl->head + 1U);
+      lvl->cells++;
+
+      if ((l + 1U) < pyr->levels)
+      {
+        pyr_acc_merge(&pyr->level[l + 1U].acc, &lvl->acc);
+      }
+
+      pyr_acc_reset(&lvl->acc);
+      lvl = &pyr->level[(l + 1U) % pyr->levels];
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Aggregated statistics over a range of frames.[get]
+  *         The range is trimmed inward to whole cells of the finest
+  *         level still retaining its start, then tiled with cells of
+  *         that level at both edges and coarser cells in the middle:
+  *         no data outside the range is used and at most two ratios of
+  *         cells per level are read.
+  *
+  * @param  pyr     aggregation pyramid.(ptr)
+  * @param  first   index of the first frame (counted since init).
+  * @param  frames  number of frames in the range.
+  * @param  val     aggregated statistics.(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pyr_range_get(const ais25ba_pyr_t *pyr, uint64_t first,
+                              uint32_t frames, ais25ba_pyr_cell_t *val)
+{
+  const ais25ba_pyr_level_t *lvl = NULL;
+  ais25ba_pyr_acc_t acc;
+  uint64_t a = 0U;
+  uint64_t b;
+  uint64_t next;
+  int32_t ret = 0;
+  uint8_t l;
+
+  if ((pyr == NULL) || (val == NULL) || (frames == 0U)) { return -1; }
+
+  for (l = 0U; l < pyr->levels; l++)
+  {
+    a = (first + pyr->level[l].span - 1U) / pyr->level[l].span;
+
+    if (pyr_cell_get(&pyr->level[l], a) != NULL)
+    {
+      lvl = &pyr->level[l];
+      break;
+    }
+  }
+
+  if (lvl == NULL) { return -1; }
+
+  a *= lvl->span;
+  b = ((first + frames) / lvl->span) * lvl->span;
+  b = (b > (lvl->cells * lvl->span)) ? (lvl->cells * lvl->span) : b;
+
+  if (b <= a) { return -1; }
+
+  pyr_acc_reset(&acc);
+
+  for (; (ret == 0) && (l < pyr->levels) && (a < b); l++)
+  {
+    lvl = &pyr->level[l];
+    next = ((l + 1U) < pyr->levels) ? pyr->level[l + 1U].span : 1U;
+
+    /* edges: this level until aligned to the next one */
+    while ((ret == 0) && (a < b) && ((a % next) != 0U))
+    {
+      ret = pyr_acc_level(&acc, lvl, a);
+      a += lvl->span;
+    }
+
+    while ((ret == 0) && (a < b) && ((b % next) != 0U))
+    {
+      b -= lvl->span;
+      ret = pyr_acc_level(&acc, lvl, b);
+    }
+
+    /* last level: middle part */
+    while ((ret == 0) && (a < b) && ((l + 1U) == pyr->levels))
+    {
+      ret = pyr_acc_level(&acc, lvl, a);
+      a += lvl->span;
+    }
+  }
+
+  if (ret == 0)
+  {
+    pyr_acc_close(&acc, val);
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup  AIS25BA_Pipeline
+  * @brief     This section groups all the functions concerning the
+  *            statically sized acquisition pipeline (block decode, raw
+  *            ring, timestamping, envelope and aggregation pyramid).
+  * @{
+  *
+  */
+
+static int32_t pipe_ring_read(const int16_t *ring, uint32_t size,
+                              uint32_t head, uint64_t written,
+                              uint64_t first, uint32_t frames, int16_t *out)
+{
+  uint64_t back;
+  uint32_t pos;
+  uint32_t i;
+
+  /* locate first from its distance to the head */
+  if (first > written) { return -1; }
+
+  back = written - first;
+
+  if ((frames > back) || (back > size)) { return -1; }
+
+  pos = (head + size - (uint32_t)back) % size;
+
+  for (i = 0U; i < frames; i++)
+  {
+    out[0] = ring[(pos * 3U) + 0U];
+    out[1] = ring[(pos * 3U) + 1U];
+    out[2] = ring[(pos * 3U) + 2U];
+    out = &out[3];
+    pos = ((pos + 1U) == size) ? 0U : (pos + 1U);
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Acquisition pipeline initialization.[set]
+  *
+  * @param  pipe     acquisition pipeline storage.(ptr)
+  * @param  md       the TDM interface configuration.(ptr)
+  * @param  tick_hz  frequency of the host timestamp counter.
+  * @param  odr_hz   nominal sensor output data rate.
+  * @param  f_lo     envelope band lower edge in Hz (if enabled).
+  * @param  f_hi     envelope band upper edge in Hz (if enabled).
+  *
+  * @retval          interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_init(ais25ba_pipe_t *pipe, const ais25ba_bus_mode_t *md,
+                          uint32_t tick_hz, float_t odr_hz,
+                          float_t f_lo, float_t f_hi)
+{
+#if (AIS25BA_CFG_PYR_EN != 0)
+  const uint16_t pyr_ratio[8] =
+  {
+    AIS25BA_CFG_PYR_RATIO_0, AIS25BA_CFG_PYR_RATIO_1,
+    AIS25BA_CFG_PYR_RATIO_2, AIS25BA_CFG_PYR_RATIO_3,
+    AIS25BA_CFG_PYR_RATIO_4, AIS25BA_CFG_PYR_RATIO_5,
+    AIS25BA_CFG_PYR_RATIO_6, AIS25BA_CFG_PYR_RATIO_7,
+  };
+  const uint16_t pyr_depth[8] =
+  {
+    AIS25BA_CFG_PYR_DEPTH_0, AIS25BA_CFG_PYR_DEPTH_1,
+    AIS25BA_CFG_PYR_DEPTH_2, AIS25BA_CFG_PYR_DEPTH_3,
+    AIS25BA_CFG_PYR_DEPTH_4, AIS25BA_CFG_PYR_DEPTH_5,
+    AIS25BA_CFG_PYR_DEPTH_6, AIS25BA_CFG_PYR_DEPTH_7,
+  };
+  uint32_t cell = 0U;
+  uint8_t l;
+#endif /* AIS25BA_CFG_PYR_EN */
+  int32_t ret;
+
+  if ((pipe == NULL) || (md == NULL)) { return -1; }
+
+  pipe->md = *md;
+  pipe->layout.width = AIS25BA_SLOT_16bit;
+  pipe->layout.justify = AIS25BA_SLOT_LEFT;
+  pipe->layout.byte_order = DRV_BYTE_ORDER;
+  pipe->frames = 0U;
+  pipe->head = 0U;
+  ret = ais25ba_ts_init(&pipe->ts, tick_hz, odr_hz, AIS25BA_TS_KP_SHIFT,
+                        AIS25BA_TS_KI_SHIFT);
+
+#if (AIS25BA_CFG_ENV_EN != 0)
+  pipe->env_frames = 0U;
+  pipe->env_head = 0U;
+
+  if (ret == 0)
+  {
+    ret = ais25ba_env_init(&pipe->env, odr_hz, f_lo, f_hi,
+                           (uint16_t)AIS25BA_CFG_ENV_DECIM);
+  }
+#else
+  (void)f_lo;
+  (void)f_hi;
+#endif /* AIS25BA_CFG_ENV_EN */
+
+#if (AIS25BA_CFG_PYR_EN != 0)
+  if (ret == 0)
+  {
+    ret = ais25ba_pyr_init(&pipe->pyr);
+  }
+
+  for (l = 0U; (ret == 0) && (l < AIS25BA_CFG_PYR_LEVELS); l++)
+  {
+    ret = ais25ba_pyr_level_add(&pipe->pyr, &pipe->pyr_cell[cell],
+                                pyr_depth[l], pyr_ratio[l]);
+    cell += pyr_depth[l];
+  }
+#endif /* AIS25BA_CFG_PYR_EN */
+
+  return ret;
+}
+
+/**
+  * @brief  Slot layout of the DMA buffers pushed in the pipeline.[set]
+  *         Default is 16 bit slots in host byte order. Unknown width,
+  *         justification or byte order is rejected.
+  *
+  * @param  pipe  acquisition pipeline storage.(ptr)
+  * @param  val   slot width, justification and byte order.(ptr)
+  *
+  * @retval       interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_layout_set(ais25ba_pipe_t *pipe,
+                                const ais25ba_tdm_layout_t *val)
+{
+  if ((pipe == NULL) || (val == NULL)) { return -1; }
+  if (tdm_layout_check(val) != 0) { return -1; }
+
+  pipe->layout = *val;
+
+  return 0;
+}
+
+/**
+  * @brief  Push a TDM block through the acquisition pipeline.[set]
+  *         Frames are decoded straight into the raw ring, which then
+  *         feeds the envelope and pyramid stages in place.
+  *
+  * @param  pipe        acquisition pipeline storage.(ptr)
+  * @param  tdm_stream  data stream from TDM interface, laid out as set
+  *                     by ais25ba_pipe_layout_set.(ptr)
+  * @param  frames      number of frames (max AIS25BA_CFG_BLOCK_FRAMES).
+  * @param  host_ts     host time of the last frame in the block (ticks).
+  *
+  * @retval             interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_block_put(ais25ba_pipe_t *pipe, const void *tdm_stream,
+                               uint32_t frames, uint32_t host_ts)
+{
+  const uint8_t *stream = (const uint8_t *)tdm_stream;
+  const int16_t *raw;
+  ais25ba_ts_t ts;
+  uint32_t pos;
+  uint32_t n;
+  int32_t ret;
+#if (AIS25BA_CFG_ENV_EN != 0)
+  uint32_t len = 0U;
+  uint32_t i;
+#endif /* AIS25BA_CFG_ENV_EN */
+
+  if ((pipe == NULL) || (tdm_stream == NULL) || (frames == 0U) ||
+      (frames > AIS25BA_CFG_BLOCK_FRAMES))
+  {
+    return -1;
+  }
+
+  /* validate layout and timestamp before any stage state is touched */
+  ret = ais25ba_raw_block_layout_get(stream, &pipe->layout, &pipe->md, 0U,
+                                     pipe->raw);
+
+  if (ret == 0)
+  {
+    ts = pipe->ts;
+    ret = ais25ba_ts_block_update(&ts, host_ts, frames);
+  }
+
+  if (ret == 0)
+  {
+    pipe->ts = ts;
+  }
+
+  /* at most two contiguous chunks, split on ring wrap */
+  while ((ret == 0) && (frames > 0U))
+  {
+    pos = pipe->head;
+    n = AIS25BA_CFG_RING_FRAMES - pos;
+    n = (n < frames) ? n : frames;
+    raw = &pipe->raw[pos * 3U];
+
+    ret = ais25ba_raw_block_layout_get(stream, &pipe->layout, &pipe->md, n,
+                                       &pipe->raw[pos * 3U]);
+
+#if (AIS25BA_CFG_ENV_EN != 0)
+    if (ret == 0)
+    {
+      ret = ais25ba_env_process(&pipe->env, raw, n, pipe->env_blk, &len);
+    }
+
+    for (i = 0U; (ret == 0) && (i < len); i++)
+    {
+      pipe->env_raw[(pipe->env_head * 3U) + 0U] = pipe->env_blk[(i * 3U) + 0U];
+      pipe->env_raw[(pipe->env_head * 3U) + 1U] = pipe->env_blk[(i * 3U) + 1U];
+      pipe->env_raw[(pipe->env_head * 3U) + 2U] = pipe->env_blk[(i * 3U) + 2U];
+      pipe->env_head = ((pipe->env_head + 1U) == AIS25BA_CFG_ENV_FRAMES) ?
+                       0U : (pipe->env_head + 1U);
+      pipe->env_frames++;
+    }
+#endif /* AIS25BA_CFG_ENV_EN */
+
+#if (AIS25BA_CFG_PYR_EN != 0)
+    if (ret == 0)
+    {
+      ret = ais25ba_pyr_update(&pipe->pyr, raw, n);
+    }
+#else
+    (void)raw;
+#endif /* AIS25BA_CFG_PYR_EN */
+
+    pipe->frames += n;
+    pipe->head = ((pos + n) == AIS25BA_CFG_RING_FRAMES) ? 0U : (pos + n);
+    stream = &stream[n * AIS25BA_TDM_SLOTS * (uint32_t)pipe->layout.width];
+    frames -= n;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Copy raw frames out of the pipeline ring.[get]
+  *
+  * @param  pipe    acquisition pipeline storage.(ptr)
+  * @param  first   index of the first frame (counted since init).
+  * @param  frames  number of frames to copy.
+  * @param  raw     x/y/z raw samples, interleaved (3 * frames).(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_raw_get(const ais25ba_pipe_t *pipe, uint64_t first,
+                             uint32_t frames, int16_t *raw)
+{
+  if ((pipe == NULL) || (raw == NULL)) { return -1; }
+
+  return pipe_ring_read(pipe->raw, AIS25BA_CFG_RING_FRAMES, pipe->head,
+                        pipe->frames, first, frames, raw);
+}
+
+#if (AIS25BA_CFG_ENV_EN != 0)
+/**
+  * @brief  Copy envelope frames out of the pipeline ring.[get]
+  *
+  * @param  pipe    acquisition pipeline storage.(ptr)
+  * @param  first   index of the first envelope frame (since init).
+  * @param  frames  number of envelope frames to copy.
+  * @param  env     x/y/z envelope samples, interleaved.(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_env_get(const ais25ba_pipe_t *pipe, uint64_t first,
+                             uint32_t frames, int16_t *env)
+{
+  if ((pipe == NULL) || (env == NULL)) { return -1; }
+
+  return pipe_ring_read(pipe->env_raw, AIS25BA_CFG_ENV_FRAMES,
+                        pipe->env_head, pipe->env_frames, first, frames, env);
+}
+#endif /* AIS25BA_CFG_ENV_EN */
+
+/**
+  * @brief  RAM footprint of the pipeline of one sensor.[get]
+  *
+  * @param  val  size in bytes of ais25ba_pipe_t with the current
+  *              AIS25BA_CFG_* configuration.(ptr)
+  *
+  * @retval      interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_pipe_footprint_get(uint32_t *val)
+{
+  if (val == NULL) { return -1; }
+
+  *val = (uint32_t)AIS25BA_PIPE_RAM_SIZE;
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup  AIS25BA_Duty_Cycle
+  * @brief     This section groups all the functions concerning duty-cycled
+  *            acquisition. Register shadows are read once at init so
+  *            every transition costs only register writes; CTRL_REG_1 and
+  *            TDM_CTRL_REG are not contiguous, hence two writes per device.
+  *            Whole shadow bytes are written back: after ais25ba_mode_set
+  *            or ais25ba_bus_mode_set on a scheduled device, call
+  *            ais25ba_duty_resync or the change is undone at the next
+  *            transition.
+  * @{
+  *
+  */
+
+static int32_t duty_dev_power_set(ais25ba_duty_t *duty,
+                                  ais25ba_duty_dev_t *dev, uint8_t on)
+{
+  int32_t ret;
+
+  uint8_t *data[2];
+  uint8_t reg[2];
+
+  dev->ctrl_reg.pd = (on == PROPERTY_ENABLE) ? 0U : 1U;
+  dev->tdm_ctrl_reg.tdm_pd = (on == PROPERTY_ENABLE) ? 0U : 1U;
+
+  /* core on before TDM at wake-up, TDM off before core at sleep */
+  if (on == PROPERTY_ENABLE)
+  {
+    reg[0] = AIS25BA_CTRL_REG_1;
+    data[0] = (uint8_t *)&dev->ctrl_reg;
+    reg[1] = AIS25BA_TDM_CTRL_REG;
+    data[1] = (uint8_t *)&dev->tdm_ctrl_reg;
+  }
+
+  else
+  {
+    reg[0] = AIS25BA_TDM_CTRL_REG;
+    data[0] = (uint8_t *)&dev->tdm_ctrl_reg;
+    reg[1] = AIS25BA_CTRL_REG_1;
+    data[1] = (uint8_t *)&dev->ctrl_reg;
+  }
+
+  ret = ais25ba_write_reg(dev->ctx, reg[0], data[0], 1);
+
+  if (ret == 0)
+  {
+    duty->writes++;
+    ret = ais25ba_write_reg(dev->ctx, reg[1], data[1], 1);
+  }
+
+  if (ret == 0)
+  {
+    duty->writes++;
+  }
+
+  return ret;
+}
+
+static int32_t duty_power_set(ais25ba_duty_t *duty, uint8_t on)
+{
+  int32_t ret = 0;
+  uint8_t i;
+
+  for (i = 0U; (ret == 0) && (i < duty->n_dev); i++)
+  {
+    ret = duty_dev_power_set(duty, &duty->dev[i], on);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Duty-cycle scheduler initialization.[set]
+  *         Reads the register shadows of every device and puts all of
+  *         them in power down; the first cycle starts at now_ms.
+  *
+  * @param  duty       duty-cycle scheduler state.(ptr)
+  * @param  dev        devices, ctx field already set.(ptr)
+  * @param  n_dev      number of devices.
+  * @param  period_ms  cycle length.
+  * @param  on_ms      powered time per cycle, settle_ms included.
+  * @param  settle_ms  startup transient discarded after each wake-up,
+  *                    0 selects AIS25BA_DUTY_TURN_ON_MS plus
+  *                    AIS25BA_DUTY_SETTLE_ODR_CYCLES output periods.
+  * @param  odr_hz     sensor output data rate.
+  * @param  now_ms     current host time.
+  *
+  * @retval            interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_duty_init(ais25ba_duty_t *duty, ais25ba_duty_dev_t *dev,
+                          uint8_t n_dev, uint32_t period_ms, uint32_t on_ms,
+                          uint32_t settle_ms, float_t odr_hz,
+                          uint32_t now_ms)
+{
+  int32_t ret = 0;
+  uint8_t i;
+
+  if ((duty == NULL) || (dev == NULL) || (n_dev == 0U) ||
+      (on_ms == 0U) || (on_ms > period_ms) || (odr_hz <= 0.0f))
+  {
+    return -1;
+  }
+
+  if (settle_ms == 0U)
+  {
+    settle_ms = AIS25BA_DUTY_TURN_ON_MS +
+                (uint32_t)((((float_t)AIS25BA_DUTY_SETTLE_ODR_CYCLES *
+                             1000.0f) / odr_hz) + 0.999f);
+  }
+
+  if (settle_ms >= on_ms) { return -1; }
+
+  duty->dev = dev;
+  duty->n_dev = n_dev;
+  duty->period_ms = period_ms;
+  duty->on_ms = on_ms;
+  duty->settle_ms = settle_ms;
+  duty->settle_frames = (uint32_t)(((float_t)settle_ms * odr_hz) / 1000.0f);
+  duty->discard = 0U;
+  duty->t0_ms = now_ms;
+  duty->writes = 0U;
+  duty->cycles = 0U;
+  duty->state = AIS25BA_DUTY_SLEEP;
+
+  for (i = 0U; (ret == 0) && (i < n_dev); i++)
+  {
+    ret = ais25ba_read_reg(dev[i].ctx, AIS25BA_CTRL_REG_1,
+                           (uint8_t *)&dev[i].ctrl_reg, 1);
+
+    if (ret == 0)
+    {
+      ret = ais25ba_read_reg(dev[i].ctx, AIS25BA_TDM_CTRL_REG,
+                             (uint8_t *)&dev[i].tdm_ctrl_reg, 1);
+    }
+  }
+
+  if (ret == 0)
+  {
+    ret = duty_power_set(duty, PROPERTY_DISABLE);
+  }
+
+  /* report counts scheduled transitions only */
+  duty->writes = 0U;
+
+  return ret;
+}
+
+/**
+  * @brief  Reload the register shadows of every device.[set]
+  *         Call after ais25ba_mode_set / ais25ba_bus_mode_set on a
+  *         scheduled device; power bits are then re-aligned to the
+  *         scheduler state, writing only devices that differ.
+  *
+  * @param  duty  duty-cycle scheduler state.(ptr)
+  *
+  * @retval       interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_duty_resync(ais25ba_duty_t *duty)
+{
+  ais25ba_duty_dev_t *dev;
+  uint8_t pd;
+  int32_t ret = 0;
+  uint8_t i;
+
+  if (duty == NULL) { return -1; }
+
+  pd = (duty->state == AIS25BA_DUTY_MEASURE) ? 0U : 1U;
+
+  for (i = 0U; (ret == 0) && (i < duty->n_dev); i++)
+  {
+    dev = &duty->dev[i];
+    ret = ais25ba_read_reg(dev->ctx, AIS25BA_CTRL_REG_1,
+                           (uint8_t *)&dev->ctrl_reg, 1);
+
+    if (ret == 0)
+    {
+      ret = ais25ba_read_reg(dev->ctx, AIS25BA_TDM_CTRL_REG,
+                             (uint8_t *)&dev->tdm_ctrl_reg, 1);
+    }
+
+    if ((ret == 0) && ((dev->ctrl_reg.pd != pd) ||
+                       (dev->tdm_ctrl_reg.tdm_pd != pd)))
+    {
+      ret = duty_dev_power_set(duty, dev, (pd == 0U) ? PROPERTY_ENABLE :
+                               PROPERTY_DISABLE);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Run the duty-cycle scheduler.[set]
+  *         Call periodically (at least once per on_ms); devices are
+  *         switched only on state changes.
+  *
+  * @param  duty    duty-cycle scheduler state.(ptr)
+  * @param  now_ms  current host time.
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_duty_tick(ais25ba_duty_t *duty, uint32_t now_ms)
+{
+  uint32_t elapsed;
+  int32_t ret = 0;
+
+  if (duty == NULL) { return -1; }
+
+  elapsed = now_ms - duty->t0_ms;
+
+  if (elapsed >= duty->period_ms)
+  {
+    duty->t0_ms += duty->period_ms * (elapsed / duty->period_ms);
+    elapsed = now_ms - duty->t0_ms;
+  }
+
+  if ((elapsed < duty->on_ms) && (duty->state == AIS25BA_DUTY_SLEEP))
+  {
+    ret = duty_power_set(duty, PROPERTY_ENABLE);
+
+    /* on bus error the state is kept and the transition retried */
+    if (ret == 0)
+    {
+      duty->discard = duty->settle_frames;
+      duty->state = AIS25BA_DUTY_MEASURE;
+      duty->cycles++;
+    }
+  }
+
+  else if ((elapsed >= duty->on_ms) && (duty->state == AIS25BA_DUTY_MEASURE))
+  {
+    ret = duty_power_set(duty, PROPERTY_DISABLE);
+
+    if (ret == 0)
+    {
+      duty->state = AIS25BA_DUTY_SLEEP;
+    }
+  }
+
+  else
+  {
+    /* no state change, no bus traffic */
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Number of leading frames of a block to discard.[get]
+  *         Drops the startup transient after wake-up and anything
+  *         received while in power down.
+  *
+  * @param  duty    duty-cycle scheduler state.(ptr)
+  * @param  frames  number of frames in the received block.
+  * @param  val     leading frames of the block to discard.(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_duty_discard_get(ais25ba_duty_t *duty, uint32_t frames,
+                                 uint32_t *val)
+{
+  if ((duty == NULL) || (val == NULL)) { return -1; }
+
+  if (duty->state == AIS25BA_DUTY_SLEEP)
+  {
+    *val = frames;
+  }
+
+  else
+  {
+    *val = (duty->discard < frames) ? duty->discard : frames;
+    duty->discard -= *val;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Energy / latency figures of the configured cycle.[get]
+  *
+  * @param  duty    duty-cycle scheduler state.(ptr)
+  * @param  on_ua   device supply current when acquiring.
+  * @param  off_ua  device supply current in power down.
+  * @param  val     duty-cycle report.(ptr)
+  *
+  * @retval         interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t ais25ba_duty_report_get(const ais25ba_duty_t *duty, float_t on_ua,
+                                float_t off_ua,
+                                ais25ba_duty_report_t *val)
+{
+  if ((duty == NULL) || (val == NULL)) { return -1; }
+
+  val->duty_permille = (uint32_t)(((uint64_t)duty->on_ms * 1000U) /
+                                  duty->period_ms);
+  val->valid_ms = duty->on_ms - duty->settle_ms;
+  val->latency_ms = (duty->period_ms - duty->on_ms) + duty->settle_ms;
+  val->cycles = duty->cycles;
+  val->writes = duty->writes;
+  val->writes_per_cycle = (duty->cycles == 0U) ? 0U :
+                          ((duty->writes + duty->cycles - 1U) / duty->cycles);
+  val->avg_ua = ((on_ua * (float_t)duty->on_ms) +
+                 (off_ua * (float_t)(duty->period_ms - duty->on_ms))) /
+                (float_t)duty->period_ms;
+
+  return 0;
+}
+
 /**
   * @}
   *
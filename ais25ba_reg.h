@@ -329,7 +329,7 @@ typedef struct
     uint8_t clk_pol  : 1; /* data valid on 0=rise/1=falling edge of BCLK */
     uint8_t clk_edge : 1; /* data on 0=first / 1=second valid edge of BCLK */
     uint8_t mapping  : 1; /* xl data in 0=slot0-1-2 / 1=slot4-5-6 */
-    uint16_t cmax    : 1; /* BCLK in a WCLK (unused if odr=_XL_HW_SEL) */
+    uint16_t cmax    : 12; /* BCLK in a WCLK (unused if odr=_XL_HW_SEL) */
   } tdm;
 } ais25ba_bus_mode_t;
 int32_t ais25ba_bus_mode_set(const stmdev_ctx_t *ctx,
@@ -365,9 +365,389 @@ typedef struct
 int32_t ais25ba_data_get(uint16_t *tdm_stream, ais25ba_bus_mode_t *md,
                          ais25ba_data_t *data);
 
+/** Number of 16 bit slots in a TDM frame (frame stride of block APIs) **/
+#ifndef AIS25BA_TDM_SLOTS
+#define AIS25BA_TDM_SLOTS                  8U
+#endif /* AIS25BA_TDM_SLOTS */
+
+int32_t ais25ba_raw_block_get(const uint16_t *tdm_stream,
+                              const ais25ba_bus_mode_t *md,
+                              uint32_t frames, int16_t *raw);
+
+typedef struct
+{
+  enum
+  {
+    AIS25BA_SLOT_16bit = 2, /* 16 bit slots */
+    AIS25BA_SLOT_24bit = 3, /* 24 bit packed slots */
+    AIS25BA_SLOT_32bit = 4, /* 32 bit padded slots */
+  } width;
+  enum
+  {
+    AIS25BA_SLOT_LEFT  = 0, /* sample in the most significant bits */
+    AIS25BA_SLOT_RIGHT = 1, /* sample in the least significant bits */
+  } justify;
+  uint16_t byte_order;      /* DRV_LITTLE_ENDIAN / DRV_BIG_ENDIAN in memory */
+} ais25ba_tdm_layout_t;
+int32_t ais25ba_raw_block_layout_get(const uint8_t *tdm_stream,
+                                     const ais25ba_tdm_layout_t *layout,
+                                     const ais25ba_bus_mode_t *md,
+                                     uint32_t frames, int16_t *raw);
+
 int32_t ais25ba_self_test_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t ais25ba_self_test_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
+/** Default timestamp loop gains (critically damped, see ais25ba_ts_init) **/
+#ifndef AIS25BA_TS_KP_SHIFT
+#define AIS25BA_TS_KP_SHIFT                4U
+#endif /* AIS25BA_TS_KP_SHIFT */
+#ifndef AIS25BA_TS_KI_SHIFT
+#define AIS25BA_TS_KI_SHIFT                10U
+#endif /* AIS25BA_TS_KI_SHIFT */
+
+typedef struct
+{
+  int64_t  start;    /* host time of first sample in last block (Q16 ticks) */
+  int64_t  next;     /* predicted host time of next sample (Q16 ticks) */
+  int64_t  period;   /* estimated sample period (Q16 ticks) */
+  int64_t  nominal;  /* nominal sample period (Q16 ticks) */
+  int64_t  ferr;     /* period error remainder below loop gain (Q16) */
+  int64_t  host;     /* last host timestamp, extended to 64 bit (ticks) */
+  uint32_t tick_hz;  /* host timestamp counter frequency */
+  uint32_t blocks;   /* number of blocks processed */
+  uint8_t  kp_shift; /* phase loop gain = 2^-kp_shift */
+  uint8_t  ki_shift; /* frequency loop gain = 2^-ki_shift */
+} ais25ba_ts_t;
+int32_t ais25ba_ts_init(ais25ba_ts_t *ts, uint32_t tick_hz, float_t odr_hz,
+                        uint8_t kp_shift, uint8_t ki_shift);
+int32_t ais25ba_ts_block_update(ais25ba_ts_t *ts, uint32_t host_ts,
+                                uint32_t frames);
+int32_t ais25ba_ts_sample_get(const ais25ba_ts_t *ts, uint32_t idx,
+                              uint32_t *val);
+int32_t ais25ba_ts_odr_get(const ais25ba_ts_t *ts, float_t *val);
+int32_t ais25ba_ts_drift_get(const ais25ba_ts_t *ts, float_t *val);
+
+typedef struct
+{
+  int32_t  b0;       /* band-pass coefficients, Q28 (b1 = 0, b2 = -b0) */
+  int32_t  a1;
+  int32_t  a2;
+  uint16_t decim;    /* output one envelope sample every decim frames */
+  uint16_t cnt;      /* frames since last output sample */
+  uint8_t  lp_shift; /* envelope low-pass gain = 2^-lp_shift */
+  struct
+  {
+    int32_t x1;
+    int32_t x2;
+    int32_t y1;
+    int32_t y2;
+    int32_t lp;      /* low-passed envelope, Q8 */
+  } axis[3];
+} ais25ba_env_t;
+int32_t ais25ba_env_init(ais25ba_env_t *env, float_t odr_hz, float_t f_lo,
+                         float_t f_hi, uint16_t decim);
+int32_t ais25ba_env_process(ais25ba_env_t *env, const int16_t *raw,
+                            uint32_t frames, int16_t *out, uint32_t *len);
+
+/** Maximum number of levels of the aggregation pyramid **/
+#ifndef AIS25BA_PYR_LEVELS
+#ifdef AIS25BA_CFG_PYR_LEVELS
+#define AIS25BA_PYR_LEVELS                 AIS25BA_CFG_PYR_LEVELS
+#else
+#define AIS25BA_PYR_LEVELS                 4U
+#endif /* AIS25BA_CFG_PYR_LEVELS */
+#endif /* AIS25BA_PYR_LEVELS */
+
+typedef struct
+{
+  int16_t  min[3];
+  int16_t  max[3];
+  int16_t  mean[3];
+  uint16_t rms[3];
+} ais25ba_pyr_cell_t;
+
+typedef struct
+{
+  int64_t  sum[3];
+  uint64_t sumsq[3];
+  int16_t  min[3];
+  int16_t  max[3];
+  uint32_t n;               /* frames accumulated */
+} ais25ba_pyr_acc_t;
+
+typedef struct
+{
+  ais25ba_pyr_cell_t *ring; /* cell storage, provided by the caller */
+  ais25ba_pyr_acc_t acc;    /* cell being accumulated */
+  uint64_t cells;           /* cells completed since init */
+  uint32_t span;            /* frames per cell */
+  uint16_t head;            /* ring position of next cell */
+  uint16_t depth;           /* number of cells in ring */
+  uint16_t ratio;           /* frames (level 0) or lower cells per cell */
+} ais25ba_pyr_level_t;
+
+typedef struct
+{
+  ais25ba_pyr_level_t level[AIS25BA_PYR_LEVELS];
+  uint8_t levels;
+} ais25ba_pyr_t;
+int32_t ais25ba_pyr_init(ais25ba_pyr_t *pyr);
+int32_t ais25ba_pyr_level_add(ais25ba_pyr_t *pyr, ais25ba_pyr_cell_t *ring,
+                              uint16_t depth, uint16_t ratio);
+int32_t ais25ba_pyr_update(ais25ba_pyr_t *pyr, const int16_t *raw,
+                           uint32_t frames);
+int32_t ais25ba_pyr_range_get(const ais25ba_pyr_t *pyr, uint64_t first,
+                              uint32_t frames, ais25ba_pyr_cell_t *val);
+
+/** @defgroup AIS25BA_Pipeline_Configuration
+  * @brief    Compile-time sizing of the static acquisition pipeline.
+  *           Override before including this file (or from the compiler
+  *           command line). No heap is used: every buffer lives in the
+  *           ais25ba_pipe_t instance placed by the caller.
+  * @{
+  *
+  */
+
+/** Maximum frames accepted by a single ais25ba_pipe_block_put call **/
+#ifndef AIS25BA_CFG_BLOCK_FRAMES
+#define AIS25BA_CFG_BLOCK_FRAMES           256U
+#endif /* AIS25BA_CFG_BLOCK_FRAMES */
+
+/** Raw x/y/z frames retained in the pipeline ring **/
+#ifndef AIS25BA_CFG_RING_FRAMES
+#define AIS25BA_CFG_RING_FRAMES            2048U
+#endif /* AIS25BA_CFG_RING_FRAMES */
+
+/** Envelope demodulation stage: 1 = enabled / 0 = removed **/
+#ifndef AIS25BA_CFG_ENV_EN
+#define AIS25BA_CFG_ENV_EN                 1
+#endif /* AIS25BA_CFG_ENV_EN */
+
+/** Envelope decimation factor and retained envelope frames **/
+#ifndef AIS25BA_CFG_ENV_DECIM
+#define AIS25BA_CFG_ENV_DECIM              24U
+#endif /* AIS25BA_CFG_ENV_DECIM */
+#ifndef AIS25BA_CFG_ENV_FRAMES
+#define AIS25BA_CFG_ENV_FRAMES             1024U
+#endif /* AIS25BA_CFG_ENV_FRAMES */
+
+/** Aggregation pyramid stage: 1 = enabled / 0 = removed **/
+#ifndef AIS25BA_CFG_PYR_EN
+#define AIS25BA_CFG_PYR_EN                 1
+#endif /* AIS25BA_CFG_PYR_EN */
+
+/** Pyramid levels (1 to 8), ratio and depth of each level; default is
+  * 1 ms / 100 ms / 1 s / 1 min cells at 24 kHz. Unused levels are ignored.
+  * The product of the used ratios (frames per top cell) must fit in 32 bit.
+  */
+#ifndef AIS25BA_CFG_PYR_LEVELS
+#define AIS25BA_CFG_PYR_LEVELS             4U
+#endif /* AIS25BA_CFG_PYR_LEVELS */
+#ifndef AIS25BA_CFG_PYR_RATIO_0
+#define AIS25BA_CFG_PYR_RATIO_0            24U
+#endif /* AIS25BA_CFG_PYR_RATIO_0 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_0
+#define AIS25BA_CFG_PYR_DEPTH_0            250U
+#endif /* AIS25BA_CFG_PYR_DEPTH_0 */
+#ifndef AIS25BA_CFG_PYR_RATIO_1
+#define AIS25BA_CFG_PYR_RATIO_1            100U
+#endif /* AIS25BA_CFG_PYR_RATIO_1 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_1
+#define AIS25BA_CFG_PYR_DEPTH_1            100U
+#endif /* AIS25BA_CFG_PYR_DEPTH_1 */
+#ifndef AIS25BA_CFG_PYR_RATIO_2
+#define AIS25BA_CFG_PYR_RATIO_2            10U
+#endif /* AIS25BA_CFG_PYR_RATIO_2 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_2
+#define AIS25BA_CFG_PYR_DEPTH_2            60U
+#endif /* AIS25BA_CFG_PYR_DEPTH_2 */
+#ifndef AIS25BA_CFG_PYR_RATIO_3
+#define AIS25BA_CFG_PYR_RATIO_3            60U
+#endif /* AIS25BA_CFG_PYR_RATIO_3 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_3
+#define AIS25BA_CFG_PYR_DEPTH_3            60U
+#endif /* AIS25BA_CFG_PYR_DEPTH_3 */
+#ifndef AIS25BA_CFG_PYR_RATIO_4
+#define AIS25BA_CFG_PYR_RATIO_4            0U
+#endif /* AIS25BA_CFG_PYR_RATIO_4 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_4
+#define AIS25BA_CFG_PYR_DEPTH_4            0U
+#endif /* AIS25BA_CFG_PYR_DEPTH_4 */
+#ifndef AIS25BA_CFG_PYR_RATIO_5
+#define AIS25BA_CFG_PYR_RATIO_5            0U
+#endif /* AIS25BA_CFG_PYR_RATIO_5 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_5
+#define AIS25BA_CFG_PYR_DEPTH_5            0U
+#endif /* AIS25BA_CFG_PYR_DEPTH_5 */
+#ifndef AIS25BA_CFG_PYR_RATIO_6
+#define AIS25BA_CFG_PYR_RATIO_6            0U
+#endif /* AIS25BA_CFG_PYR_RATIO_6 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_6
+#define AIS25BA_CFG_PYR_DEPTH_6            0U
+#endif /* AIS25BA_CFG_PYR_DEPTH_6 */
+#ifndef AIS25BA_CFG_PYR_RATIO_7
+#define AIS25BA_CFG_PYR_RATIO_7            0U
+#endif /* AIS25BA_CFG_PYR_RATIO_7 */
+#ifndef AIS25BA_CFG_PYR_DEPTH_7
+#define AIS25BA_CFG_PYR_DEPTH_7            0U
+#endif /* AIS25BA_CFG_PYR_DEPTH_7 */
+
+#if (AIS25BA_CFG_PYR_EN != 0) && \
+    ((AIS25BA_CFG_PYR_LEVELS < 1U) || (AIS25BA_CFG_PYR_LEVELS > 8U))
+#error "AIS25BA_CFG_PYR_LEVELS must be in 1..8"
+#endif /* AIS25BA_CFG_PYR_LEVELS */
+
+#if (AIS25BA_CFG_PYR_EN != 0) && (AIS25BA_PYR_LEVELS < AIS25BA_CFG_PYR_LEVELS)
+#error "AIS25BA_PYR_LEVELS must be >= AIS25BA_CFG_PYR_LEVELS"
+#endif /* AIS25BA_CFG_PYR_EN */
+
+#define AIS25BA_CFG_PYR_RATIO_USED(l)      \
+  ((AIS25BA_CFG_PYR_LEVELS > (l##U)) ? AIS25BA_CFG_PYR_RATIO_##l : 1U)
+
+/* frames per cell of each level; a level fits in 32 bit only if the one
+   below does, so the first overflowing level is always compared exactly */
+#define AIS25BA_CFG_PYR_SPAN_0   AIS25BA_CFG_PYR_RATIO_USED(0)
+#define AIS25BA_CFG_PYR_SPAN_1   \
+  (AIS25BA_CFG_PYR_SPAN_0 * AIS25BA_CFG_PYR_RATIO_USED(1))
+#define AIS25BA_CFG_PYR_SPAN_2   \
+  (AIS25BA_CFG_PYR_SPAN_1 * AIS25BA_CFG_PYR_RATIO_USED(2))
+#define AIS25BA_CFG_PYR_SPAN_3   \
+  (AIS25BA_CFG_PYR_SPAN_2 * AIS25BA_CFG_PYR_RATIO_USED(3))
+#define AIS25BA_CFG_PYR_SPAN_4   \
+  (AIS25BA_CFG_PYR_SPAN_3 * AIS25BA_CFG_PYR_RATIO_USED(4))
+#define AIS25BA_CFG_PYR_SPAN_5   \
+  (AIS25BA_CFG_PYR_SPAN_4 * AIS25BA_CFG_PYR_RATIO_USED(5))
+#define AIS25BA_CFG_PYR_SPAN_6   \
+  (AIS25BA_CFG_PYR_SPAN_5 * AIS25BA_CFG_PYR_RATIO_USED(6))
+#define AIS25BA_CFG_PYR_SPAN_7   \
+  (AIS25BA_CFG_PYR_SPAN_6 * AIS25BA_CFG_PYR_RATIO_USED(7))
+
+#if (AIS25BA_CFG_PYR_EN != 0) && \
+    ((AIS25BA_CFG_PYR_SPAN_1 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_2 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_3 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_4 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_5 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_6 > 0xFFFFFFFFU) ||                               \
+     (AIS25BA_CFG_PYR_SPAN_7 > 0xFFFFFFFFU))
+#error "product of the AIS25BA_CFG_PYR_RATIO_n values must fit in 32 bit"
+#endif /* AIS25BA_CFG_PYR_EN */
+
+#define AIS25BA_CFG_PYR_DEPTH_USED(l)      \
+  ((AIS25BA_CFG_PYR_LEVELS > (l##U)) ? AIS25BA_CFG_PYR_DEPTH_##l : 0U)
+
+/** Total pyramid cells of the configured levels **/
+#define AIS25BA_CFG_PYR_CELLS                                               \
+  (AIS25BA_CFG_PYR_DEPTH_USED(0) + AIS25BA_CFG_PYR_DEPTH_USED(1) +           \
+   AIS25BA_CFG_PYR_DEPTH_USED(2) + AIS25BA_CFG_PYR_DEPTH_USED(3) +           \
+   AIS25BA_CFG_PYR_DEPTH_USED(4) + AIS25BA_CFG_PYR_DEPTH_USED(5) +           \
+   AIS25BA_CFG_PYR_DEPTH_USED(6) + AIS25BA_CFG_PYR_DEPTH_USED(7))
+
+/**
+  * @}
+  *
+  */
+
+typedef struct
+{
+  ais25ba_bus_mode_t md;
+  ais25ba_tdm_layout_t layout;
+  ais25ba_ts_t ts;
+  uint64_t frames;          /* raw frames written since init */
+  uint32_t head;            /* raw ring position of next frame */
+  int16_t raw[3U * AIS25BA_CFG_RING_FRAMES];
+#if (AIS25BA_CFG_ENV_EN != 0)
+  ais25ba_env_t env;
+  uint64_t env_frames;      /* envelope frames written since init */
+  uint32_t env_head;        /* envelope ring position of next frame */
+  int16_t env_blk[3U * ((AIS25BA_CFG_BLOCK_FRAMES /
+                         AIS25BA_CFG_ENV_DECIM) + 1U)];
+  int16_t env_raw[3U * AIS25BA_CFG_ENV_FRAMES];
+#endif /* AIS25BA_CFG_ENV_EN */
+#if (AIS25BA_CFG_PYR_EN != 0)
+  ais25ba_pyr_t pyr;
+  ais25ba_pyr_cell_t pyr_cell[AIS25BA_CFG_PYR_CELLS];
+#endif /* AIS25BA_CFG_PYR_EN */
+} ais25ba_pipe_t;
+
+/** RAM footprint of the acquisition pipeline of one sensor (bytes) **/
+#define AIS25BA_PIPE_RAM_SIZE              (sizeof(ais25ba_pipe_t))
+
+int32_t ais25ba_pipe_init(ais25ba_pipe_t *pipe, const ais25ba_bus_mode_t *md,
+                          uint32_t tick_hz, float_t odr_hz,
+                          float_t f_lo, float_t f_hi);
+int32_t ais25ba_pipe_layout_set(ais25ba_pipe_t *pipe,
+                                const ais25ba_tdm_layout_t *val);
+int32_t ais25ba_pipe_block_put(ais25ba_pipe_t *pipe, const void *tdm_stream,
+                               uint32_t frames, uint32_t host_ts);
+int32_t ais25ba_pipe_raw_get(const ais25ba_pipe_t *pipe, uint64_t first,
+                             uint32_t frames, int16_t *raw);
+#if (AIS25BA_CFG_ENV_EN != 0)
+int32_t ais25ba_pipe_env_get(const ais25ba_pipe_t *pipe, uint64_t first,
+                             uint32_t frames, int16_t *env);
+#endif /* AIS25BA_CFG_ENV_EN */
+int32_t ais25ba_pipe_footprint_get(uint32_t *val);
+
+/** Default startup transient when ais25ba_duty_init settle_ms is 0:
+  * turn-on time from power down plus output filter settling, both
+  * conservative; tune on the target board.
+  */
+#ifndef AIS25BA_DUTY_TURN_ON_MS
+#define AIS25BA_DUTY_TURN_ON_MS            20U
+#endif /* AIS25BA_DUTY_TURN_ON_MS */
+#ifndef AIS25BA_DUTY_SETTLE_ODR_CYCLES
+#define AIS25BA_DUTY_SETTLE_ODR_CYCLES     64U
+#endif /* AIS25BA_DUTY_SETTLE_ODR_CYCLES */
+
+typedef struct
+{
+  const stmdev_ctx_t *ctx;
+  ais25ba_ctrl_reg_t ctrl_reg;         /* CTRL_REG_1 shadow */
+  ais25ba_tdm_ctrl_reg_t tdm_ctrl_reg; /* TDM_CTRL_REG shadow */
+} ais25ba_duty_dev_t;
+
+typedef struct
+{
+  ais25ba_duty_dev_t *dev;  /* devices woken up together, shared cycle */
+  uint32_t period_ms;       /* measure + sleep cycle length */
+  uint32_t on_ms;           /* powered time per cycle, settling included */
+  uint32_t settle_ms;       /* startup transient discarded after wake-up */
+  uint32_t settle_frames;   /* settle_ms converted to frames at odr */
+  uint32_t discard;         /* frames still to drop in this cycle */
+  uint32_t t0_ms;           /* start of current cycle */
+  uint32_t writes;          /* successful transition writes since init */
+  uint32_t cycles;          /* wake-ups since init */
+  uint8_t  n_dev;
+  enum
+  {
+    AIS25BA_DUTY_SLEEP   = 0,
+    AIS25BA_DUTY_MEASURE = 1,
+  } state;
+} ais25ba_duty_t;
+
+typedef struct
+{
+  uint32_t duty_permille;    /* powered time over period */
+  uint32_t valid_ms;         /* settled data per cycle */
+  uint32_t latency_ms;       /* worst case wait for settled data */
+  uint32_t cycles;           /* wake-ups since init */
+  uint32_t writes;           /* successful register writes since init */
+  uint32_t writes_per_cycle; /* measured writes per cycle, all devices */
+  float_t  avg_ua;           /* average supply current per device */
+} ais25ba_duty_report_t;
+
+int32_t ais25ba_duty_init(ais25ba_duty_t *duty, ais25ba_duty_dev_t *dev,
+                          uint8_t n_dev, uint32_t period_ms, uint32_t on_ms,
+                          uint32_t settle_ms, float_t odr_hz,
+                          uint32_t now_ms);
+int32_t ais25ba_duty_resync(ais25ba_duty_t *duty);
+int32_t ais25ba_duty_tick(ais25ba_duty_t *duty, uint32_t now_ms);
+int32_t ais25ba_duty_discard_get(ais25ba_duty_t *duty, uint32_t frames,
+                                 uint32_t *val);
+int32_t ais25ba_duty_report_get(const ais25ba_duty_t *duty, float_t on_ua,
+                                float_t off_ua,
+                                ais25ba_duty_report_t *val);
+
 /**
   * @}
   *
@@ -0,0 +1,713 @@
+/**
+  ******************************************************************************
+  * @file    ais25ba_test.c
+  * @author  Sensors Software Solution Team
+  * @brief   Golden-vector and randomized regression tests of the AIS25BA
+  *          driver, run against a mock register file.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "ais25ba_reg.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FRAMES                        257U
+#define TEST_FUZZ_ROUNDS                   64U
+
+#define CHECK(cond)                                                       \
+  do                                                                      \
+  {                                                                       \
+    if (!(cond))                                                          \
+    {                                                                     \
+      if (fails < 20U)                                                    \
+      {                                                                   \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+      }                                                                   \
+      fails++;                                                            \
+    }                                                                     \
+    checks++;                                                             \
+  } while (0)
+
+static uint32_t fails;
+static uint32_t checks;
+
+/* Mock register file ------------------------------------------------------*/
+
+typedef struct
+{
+  uint8_t reg[256];
+  uint32_t writes;
+  uint32_t reads;
+} mock_bus_t;
+
+static int32_t mock_write(void *handle, uint8_t reg, const uint8_t *bufp,
+                          uint16_t len)
+{
+  mock_bus_t *bus = (mock_bus_t *)handle;
+  uint16_t i;
+
+  for (i = 0U; i < len; i++)
+  {
+    bus->reg[(uint8_t)(reg + i)] = bufp[i];
+  }
+
+  bus->writes++;
+
+  return 0;
+}
+
+static int32_t mock_read(void *handle, uint8_t reg, uint8_t *bufp,
+                         uint16_t len)
+{
+  mock_bus_t *bus = (mock_bus_t *)handle;
+  uint16_t i;
+
+  for (i = 0U; i < len; i++)
+  {
+    bufp[i] = bus->reg[(uint8_t)(reg + i)];
+  }
+
+  bus->reads++;
+
+  return 0;
+}
+
+static void mock_init(mock_bus_t *bus, stmdev_ctx_t *ctx, uint8_t fill)
+{
+  memset(bus, 0, sizeof(*bus));
+  memset(bus->reg, fill, sizeof(bus->reg));
+  ctx->write_reg = mock_write;
+  ctx->read_reg = mock_read;
+  ctx->mdelay = NULL;
+  ctx->handle = bus;
+  ctx->priv_data = NULL;
+}
+
+/* Deterministic pseudo random generator (xorshift32) ----------------------*/
+
+static uint32_t rnd_state = 0x2545F491U;
+
+static uint32_t rnd(void)
+{
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+
+  return rnd_state;
+}
+
+/* Register encoding -------------------------------------------------------*/
+
+static void test_bus_mode_roundtrip(void)
+{
+  ais25ba_bus_mode_t set;
+  ais25ba_bus_mode_t get;
+  stmdev_ctx_t ctx;
+  mock_bus_t bus;
+  uint32_t cmax;
+  uint32_t f;
+
+  mock_init(&bus, &ctx, 0x00U);
+
+  for (cmax = 0U; cmax < 4096U; cmax++)
+  {
+    for (f = 0U; f < 16U; f++)
+    {
+      /* random background for the bits not owned by bus_mode_set */
+      bus.reg[AIS25BA_TDM_CTRL_REG] = (uint8_t)rnd();
+      bus.reg[AIS25BA_TDM_CMAX_H] = (uint8_t)rnd();
+      bus.reg[AIS25BA_TDM_CMAX_L] = (uint8_t)rnd();
+
+      memset(&set, 0, sizeof(set));
+      set.tdm.en = f & 1U;
+      set.tdm.clk_pol = (f >> 1) & 1U;
+      set.tdm.clk_edge = (f >> 2) & 1U;
+      set.tdm.mapping = (f >> 3) & 1U;
+      set.tdm.cmax = cmax;
+
+      CHECK(ais25ba_bus_mode_set(&ctx, &set) == 0);
+      CHECK(ais25ba_bus_mode_get(&ctx, &get) == 0);
+
+      CHECK(get.tdm.en == set.tdm.en);
+      CHECK(get.tdm.clk_pol == set.tdm.clk_pol);
+      CHECK(get.tdm.clk_edge == set.tdm.clk_edge);
+      CHECK(get.tdm.mapping == set.tdm.mapping);
+      CHECK(get.tdm.cmax == set.tdm.cmax);
+      CHECK((((bus.reg[AIS25BA_TDM_CMAX_H] & 0x0FU) << 8) |
+             bus.reg[AIS25BA_TDM_CMAX_L]) == cmax);
+    }
+  }
+}
+
+static void test_bus_mode_keeps_odr(void)
+{
+  const ais25ba_md_t odr[] =
+  {
+    { { AIS25BA_XL_OFF } }, { { AIS25BA_XL_8kHz } },
+    { { AIS25BA_XL_16kHz } }, { { AIS25BA_XL_24kHz } },
+    { { AIS25BA_XL_HW_SEL } },
+  };
+  ais25ba_bus_mode_t set;
+  ais25ba_md_t get;
+  stmdev_ctx_t ctx;
+  mock_bus_t bus;
+  uint8_t wclk_fq;
+  uint32_t i;
+  uint32_t r;
+
+  mock_init(&bus, &ctx, 0x00U);
+
+  for (i = 0U; i < (sizeof(odr) / sizeof(odr[0])); i++)
+  {
+    for (r = 0U; r < TEST_FUZZ_ROUNDS; r++)
+    {
+      CHECK(ais25ba_mode_set(&ctx, (ais25ba_md_t *)&odr[i]) == 0);
+      wclk_fq = bus.reg[AIS25BA_TDM_CTRL_REG] & 0x06U;
+
+      memset(&set, 0, sizeof(set));
+      set.tdm.en = rnd() & 1U;
+      set.tdm.clk_pol = rnd() & 1U;
+      set.tdm.clk_edge = rnd() & 1U;
+      set.tdm.mapping = rnd() & 1U;
+      set.tdm.cmax = rnd() & 0x0FFFU;
+      CHECK(ais25ba_bus_mode_set(&ctx, &set) == 0);
+
+      CHECK((bus.reg[AIS25BA_TDM_CTRL_REG] & 0x06U) == wclk_fq);
+      CHECK(ais25ba_mode_get(&ctx, &get) == 0);
+      CHECK(get.xl.odr == odr[i].xl.odr);
+    }
+  }
+}
+
+static void test_mode_golden(void)
+{
+  /* odr, background, CTRL_REG_1, TDM_CTRL_REG, CTRL_REG_2 */
+  const struct
+  {
+    uint8_t odr;
+    uint8_t fill;
+    uint8_t ctrl_reg_1;
+    uint8_t tdm_ctrl_reg;
+    uint8_t ctrl_reg_2;
+  } golden[] =
+  {
+    { AIS25BA_XL_OFF,    0x00U, 0x20U, 0x00U, 0x00U },
+    { AIS25BA_XL_8kHz,   0x00U, 0x00U, 0x00U, 0x00U },
+    { AIS25BA_XL_16kHz,  0x00U, 0x00U, 0x02U, 0x00U },
+    { AIS25BA_XL_24kHz,  0x00U, 0x00U, 0x04U, 0x00U },
+    { AIS25BA_XL_HW_SEL, 0x00U, 0x00U, 0x00U, 0x01U },
+    { AIS25BA_XL_OFF,    0xFFU, 0xFFU, 0xF9U, 0xFEU },
+    { AIS25BA_XL_8kHz,   0xFFU, 0xDFU, 0xF9U, 0xFEU },
+    { AIS25BA_XL_16kHz,  0xFFU, 0xDFU, 0xFBU, 0xFEU },
+    { AIS25BA_XL_24kHz,  0xFFU, 0xDFU, 0xFDU, 0xFEU },
+    { AIS25BA_XL_HW_SEL, 0xFFU, 0xDFU, 0xF9U, 0xFFU },
+  };
+  ais25ba_md_t set;
+  ais25ba_md_t get;
+  stmdev_ctx_t ctx;
+  mock_bus_t bus;
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(golden) / sizeof(golden[0])); i++)
+  {
+    mock_init(&bus, &ctx, golden[i].fill);
+    set.xl.odr = golden[i].odr;
+
+    CHECK(ais25ba_mode_set(&ctx, &set) == 0);
+    CHECK(bus.reg[AIS25BA_CTRL_REG_1] == golden[i].ctrl_reg_1);
+    CHECK(bus.reg[AIS25BA_TDM_CTRL_REG] == golden[i].tdm_ctrl_reg);
+    CHECK(bus.reg[AIS25BA_CTRL_REG_2] == golden[i].ctrl_reg_2);
+
+    CHECK(ais25ba_mode_get(&ctx, &get) == 0);
+    CHECK(get.xl.odr == set.xl.odr);
+  }
+}
+
+/* Block decode ------------------------------------------------------------*/
+
+static void reference_decode(uint16_t *tdm, ais25ba_bus_mode_t *md,
+                             uint32_t frames, int16_t *raw)
+{
+  ais25ba_data_t data;
+  uint32_t i;
+
+  for (i = 0U; i < frames; i++)
+  {
+    (void)ais25ba_data_get(&tdm[i * AIS25BA_TDM_SLOTS], md, &data);
+    raw[(i * 3U) + 0U] = data.xl.raw[0];
+    raw[(i * 3U) + 1U] = data.xl.raw[1];
+    raw[(i * 3U) + 2U] = data.xl.raw[2];
+  }
+}
+
+/* pack host order 16 bit slots into the given layout, random padding */
+static void layout_pack(const uint16_t *tdm, uint32_t slots,
+                        const ais25ba_tdm_layout_t *layout, uint8_t *buf)
+{
+  uint32_t size = (uint32_t)layout->width;
+  uint32_t shift;
+  uint32_t word;
+  uint32_t i;
+  uint32_t k;
+
+  shift = (layout->justify == AIS25BA_SLOT_LEFT) ? (8U * (size - 2U)) : 0U;
+
+  for (i = 0U; i < slots; i++)
+  {
+    word = (rnd() & ~(0xFFFFUL << shift)) | ((uint32_t)tdm[i] << shift);
+
+    for (k = 0U; k < size; k++)
+    {
+      if (layout->byte_order == DRV_BIG_ENDIAN)
+      {
+        buf[(i * size) + k] = (uint8_t)(word >> (8U * (size - 1U - k)));
+      }
+
+      else
+      {
+        buf[(i * size) + k] = (uint8_t)(word >> (8U * k));
+      }
+    }
+  }
+}
+
+static void test_block_decode_golden(void)
+{
+  /* two frames, slot n = n * 0x11, frame 1 also sets 0x8080 (sign bit) */
+  /* expected[mapping][frame], mapping 1 reads slots 4..6 */
+  uint16_t tdm[2U * AIS25BA_TDM_SLOTS];
+  const int16_t expected[2][2][3] =
+  {
+    { { 0x0000, 0x0011, 0x0022 }, { (int16_t)0x8080, (int16_t)0x8091,
+                                    (int16_t)0x80A2 } },
+    { { 0x0044, 0x0055, 0x0066 }, { (int16_t)0x80C4, (int16_t)0x80D5,
+                                    (int16_t)0x80E6 } },
+  };
+  /* 24 bit, right justified, big endian: slot n = 0xAB, hi, lo */
+  uint8_t packed[2U * AIS25BA_TDM_SLOTS * 3U];
+  const ais25ba_tdm_layout_t be24 =
+  {
+    AIS25BA_SLOT_24bit, AIS25BA_SLOT_RIGHT, DRV_BIG_ENDIAN
+  };
+  ais25ba_bus_mode_t md;
+  int16_t raw[6];
+  uint32_t m;
+  uint32_t i;
+  uint32_t f;
+
+  for (i = 0U; i < (2U * AIS25BA_TDM_SLOTS); i++)
+  {
+    f = i / AIS25BA_TDM_SLOTS;
+    tdm[i] = (uint16_t)(((f != 0U) ? 0x8080U : 0x0000U) |
+                        ((i % AIS25BA_TDM_SLOTS) * 0x11U));
+    packed[(i * 3U) + 0U] = 0xABU;
+    packed[(i * 3U) + 1U] = (uint8_t)(tdm[i] >> 8);
+    packed[(i * 3U) + 2U] = (uint8_t)tdm[i];
+  }
+
+  for (m = 0U; m < 2U; m++)
+  {
+    memset(&md, 0, sizeof(md));
+    md.tdm.mapping = m;
+
+    CHECK(ais25ba_raw_block_get(tdm, &md, 2U, raw) == 0);
+    CHECK(memcmp(&raw[0], expected[m][0], sizeof(expected[m][0])) == 0);
+    CHECK(memcmp(&raw[3], expected[m][1], sizeof(expected[m][1])) == 0);
+
+    CHECK(ais25ba_raw_block_layout_get(packed, &be24, &md, 2U, raw) == 0);
+    CHECK(memcmp(&raw[0], expected[m][0], sizeof(expected[m][0])) == 0);
+    CHECK(memcmp(&raw[3], expected[m][1], sizeof(expected[m][1])) == 0);
+  }
+}
+
+static void test_block_decode_fuzz(void)
+{
+  static uint16_t tdm[TEST_FRAMES * AIS25BA_TDM_SLOTS];
+  static uint8_t buf[TEST_FRAMES * AIS25BA_TDM_SLOTS * 4U];
+  static int16_t ref[TEST_FRAMES * 3U];
+  static int16_t raw[TEST_FRAMES * 3U];
+  const uint16_t order[2] = { DRV_LITTLE_ENDIAN, DRV_BIG_ENDIAN };
+  ais25ba_tdm_layout_t layout;
+  ais25ba_bus_mode_t md;
+  uint32_t r;
+  uint32_t m;
+  uint32_t w;
+  uint32_t j;
+  uint32_t o;
+  uint32_t i;
+
+  for (r = 0U; r < TEST_FUZZ_ROUNDS; r++)
+  {
+    for (i = 0U; i < (TEST_FRAMES * AIS25BA_TDM_SLOTS); i++)
+    {
+      tdm[i] = (uint16_t)rnd();
+    }
+
+    for (m = 0U; m < 2U; m++)
+    {
+      memset(&md, 0, sizeof(md));
+      md.tdm.mapping = m;
+      reference_decode(tdm, &md, TEST_FRAMES, ref);
+
+      CHECK(ais25ba_raw_block_get(tdm, &md, TEST_FRAMES, raw) == 0);
+      CHECK(memcmp(raw, ref, sizeof(ref)) == 0);
+
+      for (w = 2U; w <= 4U; w++)
+      {
+        for (j = 0U; j < 2U; j++)
+        {
+          for (o = 0U; o < 2U; o++)
+          {
+            layout.width = (w == 2U) ? AIS25BA_SLOT_16bit :
+                           ((w == 3U) ? AIS25BA_SLOT_24bit :
+                            AIS25BA_SLOT_32bit);
+            layout.justify = (j == 0U) ? AIS25BA_SLOT_LEFT :
+                             AIS25BA_SLOT_RIGHT;
+            layout.byte_order = order[o];
+            layout_pack(tdm, TEST_FRAMES * AIS25BA_TDM_SLOTS, &layout, buf);
+
+            memset(raw, 0, sizeof(raw));
+            CHECK(ais25ba_raw_block_layout_get(buf, &layout, &md,
+                                               TEST_FRAMES, raw) == 0);
+            CHECK(memcmp(raw, ref, sizeof(ref)) == 0);
+          }
+        }
+      }
+    }
+  }
+
+  /* invalid layouts are rejected */
+  layout.width = AIS25BA_SLOT_16bit;
+  layout.justify = AIS25BA_SLOT_LEFT;
+  layout.byte_order = 0x1234U;
+  CHECK(ais25ba_raw_block_layout_get(buf, &layout, &md, 1U, raw) != 0);
+}
+
+/* Envelope ----------------------------------------------------------------*/
+
+/* unfused per-axis reference: filter, rectify, low-pass, decimate passes */
+static uint32_t reference_env(const ais25ba_env_t *cfg, const int16_t *raw,
+                              uint32_t frames, int16_t *out)
+{
+  static int32_t y[TEST_FRAMES * 8U];
+  int32_t x1;
+  int32_t x2;
+  int32_t y1;
+  int32_t y2;
+  int32_t lp;
+  int64_t acc;
+  uint32_t n = 0U;
+  uint32_t i;
+  uint32_t j;
+
+  for (j = 0U; j < 3U; j++)
+  {
+    x1 = 0;
+    x2 = 0;
+    y1 = 0;
+    y2 = 0;
+
+    for (i = 0U; i < frames; i++)
+    {
+      acc = ((int64_t)cfg->b0 * ((int32_t)raw[(i * 3U) + j] - x2)) -
+            ((int64_t)cfg->a1 * y1) - ((int64_t)cfg->a2 * y2);
+      y[i] = (int32_t)(acc / 268435456);
+      x2 = x1;
+      x1 = raw[(i * 3U) + j];
+      y2 = y1;
+      y1 = y[i];
+    }
+
+    for (i = 0U; i < frames; i++)
+    {
+      y[i] = (y[i] < 0) ? -y[i] : y[i];
+    }
+
+    lp = 0;
+    n = 0U;
+
+    for (i = 0U; i < frames; i++)
+    {
+      lp += ((y[i] * 256) - lp) / ((int32_t)1 << cfg->lp_shift);
+
+      if (((i + 1U) % cfg->decim) == 0U)
+      {
+        out[(n * 3U) + j] = ((lp / 256) > 32767) ? (int16_t)32767 :
+                            (int16_t)(lp / 256);
+        n++;
+      }
+    }
+  }
+
+  return n;
+}
+
+static void test_envelope(void)
+{
+  static int16_t raw[TEST_FRAMES * 8U * 3U];
+  static int16_t ref[TEST_FRAMES * 8U * 3U];
+  static int16_t out[TEST_FRAMES * 8U * 3U];
+  const uint16_t decim[] = { 1U, 7U, 24U };
+  ais25ba_env_t env;
+  uint32_t frames = TEST_FRAMES * 8U;
+  uint32_t total;
+  uint32_t done;
+  uint32_t chunk;
+  uint32_t len;
+  uint32_t n;
+  uint32_t d;
+  uint32_t i;
+
+  for (i = 0U; i < (frames * 3U); i++)
+  {
+    raw[i] = (int16_t)rnd();
+  }
+
+  for (d = 0U; d < (sizeof(decim) / sizeof(decim[0])); d++)
+  {
+    CHECK(ais25ba_env_init(&env, 24000.0f, 2000.0f, 6000.0f,
+                           decim[d]) == 0);
+    n = reference_env(&env, raw, frames, ref);
+
+    /* random chunking must not change the result */
+    total = 0U;
+
+    for (done = 0U; done < frames; done += chunk)
+    {
+      chunk = 1U + (rnd() % 97U);
+      chunk = ((done + chunk) > frames) ? (frames - done) : chunk;
+      CHECK(ais25ba_env_process(&env, &raw[done * 3U], chunk,
+                                &out[total * 3U], &len) == 0);
+      total += len;
+    }
+
+    CHECK(total == n);
+    CHECK(memcmp(out, ref, (size_t)n * 3U * sizeof(int16_t)) == 0);
+  }
+}
+
+/* Aggregation pyramid -----------------------------------------------------*/
+
+static uint16_t reference_rms(const int16_t *raw, uint32_t frames,
+                              uint32_t axis)
+{
+  uint64_t sumsq = 0U;
+  uint64_t ms;
+  uint64_t r = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < frames; i++)
+  {
+    sumsq += (uint64_t)((int64_t)raw[(i * 3U) + axis] *
+                        raw[(i * 3U) + axis]);
+  }
+
+  ms = (sumsq + (frames / 2U)) / frames;
+
+  while (((r + 1U) * (r + 1U)) <= ms) { r++; }
+  if ((ms - (r * r)) > r) { r++; }
+
+  return (r > 65535U) ? (uint16_t)65535U : (uint16_t)r;
+}
+
+static void test_pyramid(void)
+{
+  static int16_t raw[960U * 3U];
+  static ais25ba_pyr_cell_t ring0[40];
+  static ais25ba_pyr_cell_t ring1[4];
+  ais25ba_pyr_cell_t cell;
+  ais25ba_pyr_t pyr;
+  uint32_t shift;
+  uint32_t k;
+  uint32_t j;
+  uint32_t i;
+
+  for (i = 0U; i < 960U; i++)
+  {
+    shift = rnd() % 16U;
+
+    for (j = 0U; j < 3U; j++)
+    {
+      raw[(i * 3U) + j] = (int16_t)((int32_t)(int16_t)rnd() >> shift);
+    }
+  }
+
+  /* full scale cell: rms of -32768 is 32768 */
+  for (i = 0U; i < 24U; i++)
+  {
+    raw[(i * 3U) + 0U] = -32768;
+  }
+
+  CHECK(ais25ba_pyr_init(&pyr) == 0);
+  CHECK(ais25ba_pyr_level_add(&pyr, ring0, 40U, 24U) == 0);
+  CHECK(ais25ba_pyr_level_add(&pyr, ring1, 4U, 10U) == 0);
+  CHECK(ais25ba_pyr_update(&pyr, raw, 960U) == 0);
+
+  for (k = 0U; k < 40U; k++)
+  {
+    CHECK(ais25ba_pyr_range_get(&pyr, k * 24U, 24U, &cell) == 0);
+
+    for (j = 0U; j < 3U; j++)
+    {
+      CHECK(cell.rms[j] == reference_rms(&raw[k * 24U * 3U], 24U, j));
+    }
+  }
+
+  for (k = 0U; k < 4U; k++)
+  {
+    CHECK(ais25ba_pyr_range_get(&pyr, k * 240U, 240U, &cell) == 0);
+
+    for (j = 0U; j < 3U; j++)
+    {
+      CHECK(cell.rms[j] == reference_rms(&raw[k * 240U * 3U], 240U, j));
+    }
+  }
+
+  CHECK(ais25ba_pyr_range_get(&pyr, 0U, 24U, &cell) == 0);
+  CHECK(cell.rms[0] == 32768U);
+
+  /* frames per cell must fit in 32 bit: 65535^3 is rejected */
+  CHECK(ais25ba_pyr_init(&pyr) == 0);
+  CHECK(ais25ba_pyr_level_add(&pyr, ring1, 4U, 65535U) == 0);
+  CHECK(ais25ba_pyr_level_add(&pyr, ring1, 4U, 65535U) == 0);
+  CHECK(ais25ba_pyr_level_add(&pyr, ring1, 4U, 65535U) != 0);
+  CHECK(pyr.levels == 2U);
+}
+
+/* Timestamp estimator -----------------------------------------------------*/
+
+static void test_timestamp_drop(void)
+{
+  /* 1 MHz host tick, 24 kHz sensor running 100 ppm fast, one block lost */
+  const double period = (1000000.0 / 24000.0) / 1.0001;
+  const double t0 = 4294967296.0 - 5000000.0;
+  const int32_t jitter[2] = { 0, 10 };
+  ais25ba_ts_t ts;
+  float_t drift;
+  double t_end;
+  int32_t err;
+  int32_t j;
+  uint32_t host;
+  uint32_t val;
+  uint32_t b;
+  uint32_t i;
+
+  for (i = 0U; i < 2U; i++)
+  {
+    CHECK(ais25ba_ts_init(&ts, 1000000U, 24000.0f, AIS25BA_TS_KP_SHIFT,
+                          AIS25BA_TS_KI_SHIFT) == 0);
+
+    for (b = 0U; b < 1500U; b++)
+    {
+      t_end = t0 + (period * (((double)b * 256.0) + 255.0));
+      j = (jitter[i] == 0) ? 0 :
+          ((int32_t)(rnd() % (uint32_t)((2 * jitter[i]) + 1)) - jitter[i]);
+      host = (uint32_t)(uint64_t)(t_end + 0.5) + (uint32_t)j;
+
+      /* block 600 is lost by the DMA, host never sees it */
+      if (b == 600U) { continue; }
+
+      CHECK(ais25ba_ts_block_update(&ts, host, 256U) == 0);
+
+      if (b >= 300U)
+      {
+        CHECK(ais25ba_ts_sample_get(&ts, 255U, &val) == 0);
+        err = (int32_t)(val - (uint32_t)(uint64_t)(t_end + 0.5));
+        CHECK((err <= (jitter[i] + 20)) && (err >= -(jitter[i] + 20)));
+      }
+    }
+
+    CHECK(ais25ba_ts_drift_get(&ts, &drift) == 0);
+    CHECK((drift > 90.0f) && (drift < 110.0f));
+  }
+
+  CHECK(ais25ba_ts_sample_get(&ts, 0U, NULL) != 0);
+  CHECK(ais25ba_ts_odr_get(&ts, NULL) != 0);
+  CHECK(ais25ba_ts_drift_get(&ts, NULL) != 0);
+}
+
+/* Duty cycle --------------------------------------------------------------*/
+
+static void test_duty_shadows(void)
+{
+  ais25ba_md_t md = { { AIS25BA_XL_24kHz } };
+  ais25ba_md_t off = { { AIS25BA_XL_OFF } };
+  ais25ba_bus_mode_t bm;
+  ais25ba_duty_dev_t dev;
+  ais25ba_duty_t duty;
+  stmdev_ctx_t ctx;
+  mock_bus_t bus;
+  uint8_t on_image[2];
+  uint8_t sleep_image[2];
+  uint32_t r;
+
+  for (r = 0U; r < TEST_FUZZ_ROUNDS; r++)
+  {
+    mock_init(&bus, &ctx, (uint8_t)rnd());
+
+    memset(&bm, 0, sizeof(bm));
+    bm.tdm.en = PROPERTY_ENABLE;
+    bm.tdm.clk_pol = rnd() & 1U;
+    bm.tdm.clk_edge = rnd() & 1U;
+    bm.tdm.mapping = rnd() & 1U;
+    bm.tdm.cmax = rnd() & 0x0FFFU;
+
+    /* measuring image from the reference APIs */
+    CHECK(ais25ba_mode_set(&ctx, &md) == 0);
+    CHECK(ais25ba_bus_mode_set(&ctx, &bm) == 0);
+    on_image[0] = bus.reg[AIS25BA_CTRL_REG_1];
+    on_image[1] = bus.reg[AIS25BA_TDM_CTRL_REG];
+
+    /* sleeping image: pd from mode_set(OFF), tdm_pd from bus_mode_set */
+    CHECK(ais25ba_mode_set(&ctx, &off) == 0);
+    sleep_image[0] = bus.reg[AIS25BA_CTRL_REG_1];
+    CHECK(ais25ba_mode_set(&ctx, &md) == 0);
+    bm.tdm.en = PROPERTY_DISABLE;
+    CHECK(ais25ba_bus_mode_set(&ctx, &bm) == 0);
+    sleep_image[1] = bus.reg[AIS25BA_TDM_CTRL_REG];
+    bm.tdm.en = PROPERTY_ENABLE;
+    CHECK(ais25ba_bus_mode_set(&ctx, &bm) == 0);
+
+    dev.ctx = &ctx;
+    CHECK(ais25ba_duty_init(&duty, &dev, 1U, 1000U, 100U, 10U, 24000.0f,
+                            0U) == 0);
+    CHECK(bus.reg[AIS25BA_CTRL_REG_1] == sleep_image[0]);
+    CHECK(bus.reg[AIS25BA_TDM_CTRL_REG] == sleep_image[1]);
+
+    CHECK(ais25ba_duty_tick(&duty, 1U) == 0);
+    CHECK(bus.reg[AIS25BA_CTRL_REG_1] == on_image[0]);
+    CHECK(bus.reg[AIS25BA_TDM_CTRL_REG] == on_image[1]);
+
+    CHECK(ais25ba_duty_tick(&duty, 500U) == 0);
+    CHECK(bus.reg[AIS25BA_CTRL_REG_1] == sleep_image[0]);
+    CHECK(bus.reg[AIS25BA_TDM_CTRL_REG] == sleep_image[1]);
+  }
+}
+
+int main(void)
+{
+  test_bus_mode_roundtrip();
+  test_bus_mode_keeps_odr();
+  test_mode_golden();
+  test_block_decode_golden();
+  test_block_decode_fuzz();
+  test_envelope();
+  test_pyramid();
+  test_timestamp_drop();
+  test_duty_shadows();
+
+  printf("ais25ba_test: %lu checks, %lu failures\n",
+         (unsigned long)checks, (unsigned long)fails);
+
+  return (fails == 0U) ? 0 : 1;
+}